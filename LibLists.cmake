@@ -10,9 +10,14 @@ SET(CMAKE_MODULE_PATH ${CMAKE_MODULE_PATH}
 FIND_PACKAGE(ExperimentalTheatre REQUIRED)
 
 
+# Threads
+FIND_PACKAGE(Threads REQUIRED)
+
+
 # Global
 SET(UNITTESTS_LIBRARIES
-    ${ExTh_LIBRARIES})
+    ${ExTh_LIBRARIES}
+    ${CMAKE_THREAD_LIBS_INIT})
 SET(UNITTESTS_INCLUDE_DIRS
     ${UNITTESTS_SRC_DIR}
     ${ExTh_INCLUDE_DIRS})
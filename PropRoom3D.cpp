@@ -1,5 +1,9 @@
 #include "catch.hpp"
 
+#include <thread>
+#include <random>
+#include <algorithm>
+
 #include <PropRoom3D/Node/Prop/Prop.h>
 
 #include <PropRoom3D/Node/Prop/Material/Metal.h>
@@ -265,3 +269,472 @@ TEST_CASE("Shape/Surface/Spheres/Raycast",
         REQUIRE(reports[0].position == glm::dvec3(1, 0, 0));
     }
 }
+
+TEST_CASE("Shape/Surface/Mixed/isIn",
+          "Point position in nested combinations of spheres and a plane")
+{
+    pSurf negSphere(
+        new Sphere(glm::dvec3(-1, 0, 0), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(1,  0, 0), 2.0));
+    pSurf xPalne(
+        Plane::plane(glm::dvec3(1, 0, 0), glm::dvec3(0)));
+
+    SECTION("OR combination")
+    {
+        pSurf comb = (negSphere | posSphere) | xPalne;
+
+        // Decided by the spheres alone
+        REQUIRE(comb->isIn(-1,    0,  0) == EPointPosition::IN);
+        REQUIRE(comb->isIn( 2.5,  0,  0) == EPointPosition::IN);
+
+        // Decided by the plane alone
+        REQUIRE(comb->isIn(-3.5,  0,  0) == EPointPosition::IN);
+        REQUIRE(comb->isIn(-0.5,  0,  3) == EPointPosition::IN);
+
+        // Out of every operand
+        REQUIRE(comb->isIn( 3.5,  0,  0) == EPointPosition::OUT);
+        REQUIRE(comb->isIn( 0.5,  3,  0) == EPointPosition::OUT);
+    }
+
+    SECTION("AND combination")
+    {
+        pSurf comb = (negSphere | posSphere) & xPalne;
+
+        // In every operand
+        REQUIRE(comb->isIn(-1,    0,  0) == EPointPosition::IN);
+        REQUIRE(comb->isIn(-0.5,  1,  0) == EPointPosition::IN);
+
+        // Out of the spheres alone
+        REQUIRE(comb->isIn(-3.5,  0,  0) == EPointPosition::OUT);
+        REQUIRE(comb->isIn(-0.5,  0,  3) == EPointPosition::OUT);
+
+        // Out of the plane alone
+        REQUIRE(comb->isIn( 1,    0,  0) == EPointPosition::OUT);
+        REQUIRE(comb->isIn( 2.5,  0,  0) == EPointPosition::OUT);
+    }
+}
+
+TEST_CASE("Shape/Surface/Mixed/Raycast",
+          "Raycasts in nested combinations of spheres and a plane")
+{
+    pSurf negSphere(
+        new Sphere(glm::dvec3(-1, 0, 0), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(1,  0, 0), 2.0));
+    pSurf xPalne(
+        Plane::plane(glm::dvec3(1, 0, 0), glm::dvec3(0)));
+
+    Raycast xPosRay(glm::dvec3(-4,  0,  0), glm::dvec3( 1,  0,  0));
+    Raycast xNegRay(glm::dvec3( 4,  0,  0), glm::dvec3(-1,  0,  0));
+
+
+    SECTION("OR combination")
+    {
+        pSurf comb = (negSphere | posSphere) | xPalne;
+        RayHitList reports(memoryPool);
+
+        // Enters from the plane's half-space, exits the positive sphere
+        reports.clear();
+        comb->raycast(xPosRay, reports);
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].distance == 7.0);
+        REQUIRE(reports[0].position == glm::dvec3( 3, 0, 0));
+
+        // Enters the positive sphere, never leaves the plane's half-space
+        reports.clear();
+        comb->raycast(xNegRay, reports);
+        REQUIRE(reports.size() == 1);
+        REQUIRE(reports[0].distance == 1.0);
+        REQUIRE(reports[0].position == glm::dvec3( 3, 0, 0));
+    }
+
+    SECTION("AND combination")
+    {
+        pSurf comb = (negSphere | posSphere) & xPalne;
+        RayHitList reports(memoryPool);
+
+        // Enters the negative sphere, exits through the plane
+        reports.clear();
+        comb->raycast(xPosRay, reports);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].distance == 1.0);
+        REQUIRE(reports[1].distance == 4.0);
+        REQUIRE(reports[0].position == glm::dvec3(-3, 0, 0));
+        REQUIRE(reports[1].position == glm::dvec3( 0, 0, 0));
+
+        // Enters through the plane, exits the negative sphere
+        reports.clear();
+        comb->raycast(xNegRay, reports);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].distance == 7.0);
+        REQUIRE(reports[1].distance == 4.0);
+        REQUIRE(reports[0].position == glm::dvec3(-3, 0, 0));
+        REQUIRE(reports[1].position == glm::dvec3( 0, 0, 0));
+    }
+}
+
+pSurf planeBox()
+{
+    // Axis-aligned cube spanning [-1, 1] on every axis
+    pSurf pxPalne(Plane::plane(glm::dvec3( 1, 0, 0), glm::dvec3( 1, 0, 0)));
+    pSurf nxPalne(Plane::plane(glm::dvec3(-1, 0, 0), glm::dvec3(-1, 0, 0)));
+    pSurf pyPalne(Plane::plane(glm::dvec3( 0, 1, 0), glm::dvec3( 0, 1, 0)));
+    pSurf nyPalne(Plane::plane(glm::dvec3( 0,-1, 0), glm::dvec3( 0,-1, 0)));
+    pSurf pzPalne(Plane::plane(glm::dvec3( 0, 0, 1), glm::dvec3( 0, 0, 1)));
+    pSurf nzPalne(Plane::plane(glm::dvec3( 0, 0,-1), glm::dvec3( 0, 0,-1)));
+
+    return pxPalne & nxPalne & pyPalne & nyPalne & pzPalne & nzPalne;
+}
+
+TEST_CASE("Shape/Surface/Box/isIn",
+          "Point position in a box made of six planes")
+{
+    pSurf box = planeBox();
+
+    // Inside
+    REQUIRE(box->isIn( 0,    0,    0)   == EPointPosition::IN);
+    REQUIRE(box->isIn( 0.5, -0.5,  0.5) == EPointPosition::IN);
+
+    // Outside of a single face
+    REQUIRE(box->isIn( 2,  0,  0) == EPointPosition::OUT);
+    REQUIRE(box->isIn( 0, -2,  0) == EPointPosition::OUT);
+    REQUIRE(box->isIn( 0,  0,  2) == EPointPosition::OUT);
+
+    // Outside of a corner
+    REQUIRE(box->isIn(-2, -2, -2) == EPointPosition::OUT);
+}
+
+TEST_CASE("Shape/Surface/Box/Raycast",
+          "Raycasts through a box made of six planes")
+{
+    pSurf box = planeBox();
+    RayHitList reports(memoryPool);
+
+
+    // Enters through -x face, exits through +z face
+    reports.clear();
+    Raycast aRay(glm::dvec3(-3, -2.5, -2), glm::dvec3(1, 1, 1));
+    box->raycast(aRay, reports);
+    REQUIRE(reports.size() == 2);
+    REQUIRE(reports[0].distance == 2.0);
+    REQUIRE(reports[1].distance == 3.0);
+    REQUIRE(reports[0].position == glm::dvec3(-1, -0.5, 0));
+    REQUIRE(reports[1].position == glm::dvec3( 0,  0.5, 1));
+
+    // Enters through +x face, exits through -x face
+    reports.clear();
+    Raycast bRay(glm::dvec3( 2, 0.5, 0.25), glm::dvec3(-1, -0.25, 0.125));
+    box->raycast(bRay, reports);
+    REQUIRE(reports.size() == 2);
+    REQUIRE(reports[0].distance == 1.0);
+    REQUIRE(reports[1].distance == 3.0);
+    REQUIRE(reports[0].position == glm::dvec3( 1,  0.25, 0.375));
+    REQUIRE(reports[1].position == glm::dvec3(-1, -0.25, 0.625));
+}
+
+TEST_CASE("Shape/Surface/Spheres/Translated",
+          "Raycasts in a translated intersection of two spheres")
+{
+    // Same lens as in Spheres/Raycast, moved by (2, 3, 5)
+    pSurf negSphere(
+        new Sphere(glm::dvec3(1, 3, 5), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(3, 3, 5), 2.0));
+    pSurf comb = negSphere & posSphere;
+    RayHitList reports(memoryPool);
+
+
+    // Aligned with spheres and x axis
+    reports.clear();
+    Raycast xRay(glm::dvec3(-2, 3, 5), glm::dvec3(1, 0, 0));
+    comb->raycast(xRay, reports);
+    REQUIRE(reports.size() == 2);
+    REQUIRE(reports[0].distance == 5.0);
+    REQUIRE(reports[1].distance == 3.0);
+    REQUIRE(reports[0].position == glm::dvec3(3, 3, 5));
+    REQUIRE(reports[1].position == glm::dvec3(1, 3, 5));
+
+    // Aligned with y axis and on negative x sphere
+    reports.clear();
+    Raycast yNegXRay(glm::dvec3(1, 3, 9), glm::dvec3(0, 0, -1));
+    comb->raycast(yNegXRay, reports);
+    REQUIRE(reports.size() == 1);
+    REQUIRE(reports[0].distance == 4.0);
+    REQUIRE(reports[0].position == glm::dvec3(1, 3, 5));
+
+    // Aligned with y axis and under positive x sphere
+    reports.clear();
+    Raycast yPosXRay(glm::dvec3(3, 3, 1), glm::dvec3(0, 0, 1));
+    comb->raycast(yPosXRay, reports);
+    REQUIRE(reports.size() == 1);
+    REQUIRE(reports[0].distance == 4.0);
+    REQUIRE(reports[0].position == glm::dvec3(3, 3, 5));
+}
+
+TEST_CASE("Shape/Surface/Concurrent/Raycast",
+          "Concurrent raycasts in a shared combination of surfaces")
+{
+    pSurf negSphere(
+        new Sphere(glm::dvec3(-1, 0, 0), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(1,  0, 0), 2.0));
+    pSurf xPalne(
+        Plane::plane(glm::dvec3(1, 0, 0), glm::dvec3(0)));
+    pSurf yPalne(
+        Plane::plane(glm::dvec3(0, 1, 0), glm::dvec3(0)));
+    pSurf zPalne(
+        Plane::plane(glm::dvec3(0, 0, 1), glm::dvec3(0)));
+
+    pSurf comb = (negSphere & posSphere) | (xPalne & yPalne & zPalne);
+
+    std::vector<Raycast> rays;
+    rays.push_back(Raycast(glm::dvec3(-4,  0,  0), glm::dvec3( 1,  0,  0)));
+    rays.push_back(Raycast(glm::dvec3(-1,  0,  4), glm::dvec3( 0,  0, -1)));
+    rays.push_back(Raycast(glm::dvec3( 1,  0, -4), glm::dvec3( 0,  0,  1)));
+    rays.push_back(Raycast(glm::dvec3( 1,  1,  1), glm::dvec3(-1, -1, -1)));
+    rays.push_back(Raycast(glm::dvec3( 1,  1,  2), glm::dvec3(-1,-.75, -1)));
+
+    // Flattens every hit of every ray into a single comparable sequence
+    auto castAll = [&](std::vector<RayHitReport*>& pool) -> std::vector<double>
+    {
+        std::vector<double> hits;
+        RayHitList reports(pool);
+        for(const Raycast& ray : rays)
+        {
+            reports.clear();
+            comb->raycast(ray, reports);
+            hits.push_back(reports.size());
+            for(size_t i=0; i < reports.size(); ++i)
+            {
+                hits.push_back(reports[i].distance);
+                hits.push_back(reports[i].position.x);
+                hits.push_back(reports[i].position.y);
+                hits.push_back(reports[i].position.z);
+            }
+        }
+        return hits;
+    };
+
+    const std::vector<double> expected = castAll(memoryPool);
+
+    const int THREAD_COUNT = 8;
+    const int ITERATION_COUNT = 200;
+    std::vector<int> mismatches(THREAD_COUNT, 0);
+    std::vector<std::thread> threads;
+    for(int t=0; t < THREAD_COUNT; ++t)
+    {
+        threads.push_back(std::thread([&, t]()
+        {
+            // Report pools are not shared between threads
+            std::vector<RayHitReport*> threadPool;
+            for(int i=0; i < ITERATION_COUNT; ++i)
+            {
+                if(castAll(threadPool) != expected)
+                    ++mismatches[t];
+            }
+        }));
+    }
+
+    for(std::thread& thread : threads)
+        thread.join();
+
+    for(int t=0; t < THREAD_COUNT; ++t)
+        REQUIRE(mismatches[t] == 0);
+}
+
+TEST_CASE("Shape/Surface/Spheres/Row",
+          "Point position and raycasts in a union of many spheres")
+{
+    // Disjoint unit spheres centered at x = 0, 3, 6, ...
+    const int SPHERE_COUNT = 8;
+    pSurf row(new Sphere(glm::dvec3(0, 0, 0), 1.0));
+    for(int i=1; i < SPHERE_COUNT; ++i)
+        row = row | pSurf(new Sphere(glm::dvec3(3 * i, 0, 0), 1.0));
+
+
+    SECTION("isIn")
+    {
+        for(int i=0; i < SPHERE_COUNT; ++i)
+        {
+            REQUIRE(row->isIn(3 * i,       0, 0) == EPointPosition::IN);
+            REQUIRE(row->isIn(3 * i + 1.5, 0, 0) == EPointPosition::OUT);
+            REQUIRE(row->isIn(3 * i,       2, 0) == EPointPosition::OUT);
+        }
+    }
+
+    SECTION("Raycast")
+    {
+        RayHitList reports(memoryPool);
+
+        // Aligned with x axis through every sphere
+        reports.clear();
+        Raycast xRay(glm::dvec3(-2, 0, 0), glm::dvec3(1, 0, 0));
+        row->raycast(xRay, reports);
+        REQUIRE(reports.size() == 2 * SPHERE_COUNT);
+        for(int i=0; i < SPHERE_COUNT; ++i)
+        {
+            REQUIRE(reports[2*i].distance   == 3 * i + 1.0);
+            REQUIRE(reports[2*i+1].distance == 3 * i + 3.0);
+            REQUIRE(reports[2*i].position   == glm::dvec3(3 * i - 1, 0, 0));
+            REQUIRE(reports[2*i+1].position == glm::dvec3(3 * i + 1, 0, 0));
+        }
+
+        // Parallel to the row, above every sphere
+        reports.clear();
+        Raycast missRay(glm::dvec3(-2, 2, 0), glm::dvec3(1, 0, 0));
+        row->raycast(missRay, reports);
+        REQUIRE(reports.size() == 0);
+
+        // Aligned with z axis through the fourth sphere
+        reports.clear();
+        Raycast zRay(glm::dvec3(9, 0, 4), glm::dvec3(0, 0, -1));
+        row->raycast(zRay, reports);
+        REQUIRE(reports.size() == 2);
+        REQUIRE(reports[0].distance == 3.0);
+        REQUIRE(reports[1].distance == 5.0);
+        REQUIRE(reports[0].position == glm::dvec3(9, 0, 1));
+        REQUIRE(reports[1].position == glm::dvec3(9, 0,-1));
+    }
+}
+
+TEST_CASE("Shape/Surface/Grid/isIn",
+          "Point position on a dense grid against analytic classification")
+{
+    pSurf negSphere(
+        new Sphere(glm::dvec3(-1, 0, 0), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(1,  0, 0), 2.0));
+    pSurf xPalne(
+        Plane::plane(glm::dvec3(1, 0, 0), glm::dvec3(0)));
+    pSurf yPalne(
+        Plane::plane(glm::dvec3(0, 1, 0), glm::dvec3(0)));
+    pSurf zPalne(
+        Plane::plane(glm::dvec3(0, 0, 1), glm::dvec3(0)));
+
+    pSurf sphereOr = negSphere | posSphere;
+    pSurf sphereAnd = negSphere & posSphere;
+    pSurf planeOr = xPalne | yPalne | zPalne;
+    pSurf planeAnd = xPalne & yPalne & zPalne;
+
+    // Coordinates are odd multiples of 1/8, which never lie exactly
+    // on any of the planes or spheres above.
+    const int GRID_SIZE = 28;
+    int mismatches = 0;
+    for(int i=0; i < GRID_SIZE; ++i)
+    {
+        for(int j=0; j < GRID_SIZE; ++j)
+        {
+            for(int k=0; k < GRID_SIZE; ++k)
+            {
+                double x = -3.375 + 0.25 * i;
+                double y = -3.375 + 0.25 * j;
+                double z = -3.375 + 0.25 * k;
+
+                bool inNeg = (x+1)*(x+1) + y*y + z*z < 4.0;
+                bool inPos = (x-1)*(x-1) + y*y + z*z < 4.0;
+                bool inAll = x < 0 && y < 0 && z < 0;
+                bool inAny = x < 0 || y < 0 || z < 0;
+
+                if((sphereOr->isIn(x, y, z) == EPointPosition::IN) !=
+                   (inNeg || inPos)) ++mismatches;
+                if((sphereAnd->isIn(x, y, z) == EPointPosition::IN) !=
+                   (inNeg && inPos)) ++mismatches;
+                if((planeOr->isIn(x, y, z) == EPointPosition::IN) !=
+                   inAny) ++mismatches;
+                if((planeAnd->isIn(x, y, z) == EPointPosition::IN) !=
+                   inAll) ++mismatches;
+            }
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("Shape/Surface/Random/Raycast",
+          "Raycast results do not depend on the order rays are cast in")
+{
+    pSurf negSphere(
+        new Sphere(glm::dvec3(-1, 0, 0), 2.0));
+    pSurf posSphere(
+        new Sphere(glm::dvec3(1,  0, 0), 2.0));
+    pSurf xPalne(
+        Plane::plane(glm::dvec3(1, 0, 0), glm::dvec3(0)));
+    pSurf yPalne(
+        Plane::plane(glm::dvec3(0, 1, 0), glm::dvec3(0)));
+    pSurf zPalne(
+        Plane::plane(glm::dvec3(0, 0, 1), glm::dvec3(0)));
+
+    std::vector<pSurf> scenes;
+    scenes.push_back(negSphere | posSphere);
+    scenes.push_back(negSphere & posSphere);
+    scenes.push_back(xPalne | yPalne | zPalne);
+    scenes.push_back(xPalne & yPalne & zPalne);
+    scenes.push_back(planeBox());
+
+    // Fixed seed so that failures can be reproduced
+    const int RAY_COUNT = 256;
+    std::mt19937 generator(1234);
+    std::uniform_real_distribution<double> originDist(-4.0, 4.0);
+    std::uniform_real_distribution<double> directionDist(-1.0, 1.0);
+
+    std::vector<Raycast> rays;
+    for(int i=0; i < RAY_COUNT; ++i)
+    {
+        glm::dvec3 origin(
+            originDist(generator),
+            originDist(generator),
+            originDist(generator));
+        glm::dvec3 direction(
+            directionDist(generator),
+            directionDist(generator),
+            directionDist(generator));
+        rays.push_back(Raycast(origin, direction));
+    }
+
+    std::vector<int> order(RAY_COUNT);
+    for(int i=0; i < RAY_COUNT; ++i)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), generator);
+
+    for(const pSurf& scene : scenes)
+    {
+        RayHitList reports(memoryPool);
+
+        // Casts the rays in the given order and scatters results back
+        // to their original index
+        auto castAll = [&](const std::vector<int>& castOrder)
+            -> std::vector<std::vector<double>>
+        {
+            std::vector<std::vector<double>> hits(RAY_COUNT);
+            for(int r : castOrder)
+            {
+                reports.clear();
+                scene->raycast(rays[r], reports);
+                for(size_t i=0; i < reports.size(); ++i)
+                {
+                    hits[r].push_back(reports[i].distance);
+                    hits[r].push_back(reports[i].position.x);
+                    hits[r].push_back(reports[i].position.y);
+                    hits[r].push_back(reports[i].position.z);
+                }
+            }
+            return hits;
+        };
+
+        std::vector<int> identity(order);
+        std::sort(identity.begin(), identity.end());
+
+        std::vector<std::vector<double>> inOrder = castAll(identity);
+        std::vector<std::vector<double>> shuffled = castAll(order);
+
+        int mismatches = 0;
+        for(int r=0; r < RAY_COUNT; ++r)
+        {
+            if(inOrder[r] != shuffled[r])
+                ++mismatches;
+        }
+
+        REQUIRE(mismatches == 0);
+    }
+}